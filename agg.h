@@ -0,0 +1,140 @@
+#ifndef AGG_H
+#define AGG_H
+
+#include "heapfile.h"
+
+// An Aggregator computes COUNT, SUM, MIN, MAX and AVG of numeric
+// attributes over the records fed to it, either over all of them or
+// for each value of a group attribute (INTEGER, FLOAT or STRING).
+// Records come one at a time, in caller batches, or straight from a
+// HeapFileScan.  Each batch is first projected into columns, the group
+// value and the aggregated attributes as doubles, and then hashed,
+// looked up and accumulated one column at a time in tight loops.
+//
+// Groups live in a chained hash table in a workspace of the budget's
+// pages.  Once it is full, rows of groups not in it are written, as
+// projected rows, to one of several partitions, temporary heap files
+// that each hold two frames while open; groups in the table go on
+// accumulating.  When input ends the table's groups are returned, then
+// each partition is aggregated the same way, partitioned again with
+// another hash function if its groups still do not fit.  Records too
+// short to hold an attribute used are skipped.
+
+enum AggFunc { COUNT, SUM, MIN, MAX, AVG };
+
+struct AggSpec
+{
+  AggFunc	func;
+  AttrDesc	attr;		// attribute aggregated, ignored by COUNT
+};
+
+const int MAXAGGS = 8;		// aggregates per Aggregator
+const int AGGBATCH = 256;	// records projected and accumulated at once
+const int MAXAGGLEVEL = 16;	// times a partition may be partitioned again
+
+struct AggStats
+{
+  int records;    // records fed in
+  int groups;     // groups returned
+  int partitions; // temporary partitions written
+  int spillRecs;  // rows written to partitions
+
+  void clear()
+    {
+      records = groups = partitions = spillRecs = 0;
+    }
+
+  AggStats()
+    {
+      clear();
+    }
+};
+
+class Aggregator {
+public:
+
+    // compute aggs[0..aggCnt) for each value of groupAttr, or over all
+    // records if groupAttr is NULL, in a budget of maxFrames buffer
+    // pool frames; partitions are named after tmpName.  BADSCANPARM if
+    // an attribute is malformed or aggCnt is out of range,
+    // ATTRTYPEMISMATCH if a STRING attribute is aggregated by other
+    // than COUNT, INSUFMEM if maxFrames is below 8
+    Aggregator(const string & tmpName, const AttrDesc* groupAttr,
+               const AggSpec aggs[], const int aggCnt, const int maxFrames,
+               Status & status);
+    ~Aggregator();
+
+    // feed one record, or cnt of them
+    const Status add(const Record & rec);
+    const Status addBatch(const Record recs[], const int cnt);
+
+    // feed the records a started scan has yet to return
+    const Status addScan(HeapFileScan & scan);
+
+    // return the next group: its value (NULL without a group attribute)
+    // and its aggregates in the order given, good until the next call;
+    // FILEEOF after the last one.  Without a group attribute there is
+    // always one, with zero aggregates if no record was fed.
+    const Status next(const char* & groupVal, const double* & values);
+
+    const AggStats & getAggStats() const // get group and partition counts
+    {
+	return aggStats;
+    }
+
+private:
+    // a partition to aggregate
+    struct AggTask
+    {
+	string	fileName;
+	int	level;
+    };
+
+    string	tmpName;
+    bool	grouped;
+    AttrDesc	groupAttr;
+    AggSpec	aggs[MAXAGGS];
+    int		aggCnt;
+    int		maxFrames;
+    int		keyLen;		// group value bytes, padded to 8
+    int		entrySize;
+    AggStats	aggStats;
+
+    // workspace: a chained hash table of groups.  An entry is the offset
+    // of the next entry in its chain (-1 at the end), the hash, the group
+    // value, the record count and one accumulator per aggregate.
+    vector<char> work;
+    vector<int>	table;		// first entry of each chain, -1 if none
+    int		workUsed;	// bytes of work in use
+
+    // the batch being projected: group values, and the values of
+    // aggregate a from batchVals[a * AGGBATCH]
+    vector<char> batchKeys;
+    vector<double> batchVals;
+    int		batchCnt;
+    unsigned	hashes[AGGBATCH];
+    int		groups[AGGBATCH];	// entry of each row, -1 if spilled
+
+    // partitions of the level being aggregated, opened on first spill
+    int		level;
+    int		fanOut;		// partitions a level spills to
+    int		partCnt;	// partitions open, 0 or fanOut
+    vector<string> partNames;
+    vector<InsertFileScan*> partScans;
+    vector<AggTask> tasks;
+
+    bool	finished;	// input ended, groups being returned
+    int		nextEntry;	// entry of work next() returns next
+    vector<double> results;
+
+    const bool project(const Record & rec);
+    const Status flushBatch();
+    const int findGroup(const char* key, const unsigned hash);
+    const int newGroup(const char* key, const unsigned hash);
+    const Status spillRow(const int i);
+    void resetWork();
+    const Status closeParts();
+    const Status aggregatePart(const AggTask & task);
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include "heapfile.h"
+
+// A B+-tree index maps the values of one attribute (offset, length,
+// type) of a heap file's records to their RIDs.  It lives in its own
+// file: a header page followed by node pages, all read through the
+// buffer pool.
+//
+// Entries are ordered by key and then by RID, so every entry is
+// distinct even when keys repeat, and internal separators are full
+// (key, RID) pairs.  Leaves are chained left to right for range scans.
+// Deleting an entry never merges nodes; a leaf may become empty and
+// stays in the chain.
+
+const int MAXKEYLEN = 128;  // longest STRING key
+const int BUILDSORTPAGES = 256;  // memory for sorting entries in a bulk build
+const int BUILDRUNPAGES = 32;    // nodes of a level a bulk build writes at once
+
+struct BTreeHdrPage
+{
+  char		indexName[MAXNAMESIZE]; // name of index file
+  char		relName[MAXNAMESIZE];   // heap file the index was built on
+  int		offset;		// byte offset of key attribute within record
+  int		length;		// length of key attribute
+  Datatype	type;		// datatype of key attribute
+  int		unique;		// nonzero if keys may not repeat
+  int		rootPage;	// pageNo of root node
+  int		height;		// levels in the tree, 1 if the root is a leaf
+  int		firstLeaf;	// pageNo of leftmost leaf
+  int		entryCnt;	// number of entries
+  int		nodeCnt;	// number of node pages
+};
+
+// Node page.  A leaf holds keyCnt entries of a key padded to a multiple
+// of 4 bytes followed by a RID.  An internal node starts with the pageNo
+// of its leftmost child, followed by keyCnt entries of key, RID and
+// the child holding entries greater than or equal to that (key, RID).
+
+struct BTreeNode
+{
+  short		level;		// 0 for leaves
+  short		keyCnt;		// entries in use
+  int		nextNode;	// right sibling of a leaf, -1 if last
+  char		data[PAGESIZE - 2*sizeof(short) - sizeof(int)];
+};
+
+// create an index named indexName over attribute (offset, length, type)
+// of the records of heap file relName.  The records relName already
+// holds are indexed in one bulk pass: their entries are sorted in
+// sortPages pages of memory and written bottom-up to full nodes.  With
+// unique set, a repeated key is NONUNIQUEENTRY.
+const Status createBTreeIndex(const string indexName, const string relName,
+                              const int offset, const int length,
+                              const Datatype type, const bool unique = false,
+                              const int sortPages = BUILDSORTPAGES);
+const Status destroyBTreeIndex(const string indexName);
+
+class BTreeIndex {
+public:
+
+    BTreeIndex(const string & name, Status & status);
+    ~BTreeIndex();
+
+    // add entry (key, rid), where key points at length bytes
+    const Status insertEntry(const char* key, const RID & rid);
+
+    // remove entry (key, rid); RECNOTFOUND if it is not in the index
+    const Status deleteEntry(const char* key, const RID & rid);
+
+    // scan the entries whose key satisfies "key op filter"
+    const Status startScan(const char* filter, const Operator op);
+
+    // scan the entries with lowVal lowOp key highOp highKey, where lowOp
+    // is GT or GTE and highOp LT or LTE; a NULL bound is open
+    const Status startScan(const char* lowVal, const Operator lowOp,
+                           const char* highVal, const Operator highOp);
+
+    // return RID of next entry in key order; NOMORERECS at the end
+    const Status scanNext(RID & outRid);
+
+    const Status endScan(); // terminate the scan
+
+    const BTreeHdrPage & getHeader() const // get index parameters and counts
+    {
+	return *headerPage;
+    }
+
+private:
+    File*	filePtr;	// underlying DB File object
+    BTreeHdrPage* headerPage;	// pinned index header page
+    int		headerPageNo;	// page number of header page
+    bool	hdrDirtyFlag;	// true if header page has been updated
+    int		keySize;	// key bytes in an entry, length padded to 4
+    int		leafCap;	// entries per leaf
+    int		nodeCap;	// entries per internal node
+
+    // scan state: the leaf holding the next entry stays pinned
+    int		curPageNo;	// leaf of the scan, -1 once it has ended
+    BTreeNode*	curPage;
+    int		curEntry;	// next entry of curPage to look at
+    bool	hasHigh;	// scan has an upper bound highOp highKey
+    bool	hasNe;		// scan skips keys equal to neKey
+    Operator	highOp;
+    char	highKey[MAXKEYLEN];
+    char	neKey[MAXKEYLEN];
+
+    const int leafEntrySize() const { return keySize + sizeof(RID); }
+    const int nodeEntrySize() const { return keySize + sizeof(RID) + sizeof(int); }
+    char* leafEntry(BTreeNode* node, const int i) const
+    { return &node->data[i * leafEntrySize()]; }
+    char* nodeEntry(BTreeNode* node, const int i) const
+    { return &node->data[sizeof(int) + i * nodeEntrySize()]; }
+
+    const int keyCompare(const char* a, const char* b) const;
+    const int entryCompare(const char* a, const RID & ra,
+                           const char* b, const RID & rb) const;
+    const int leafSearch(BTreeNode* leaf, const char* key, const RID & rid) const;
+    const int nodeSearch(BTreeNode* node, const char* key, const RID & rid) const;
+    const int childAt(BTreeNode* node, const int i) const;
+
+    const Status findLeaf(const char* key, const RID & rid,
+                          vector<int> & path, int & leafNo, BTreeNode* & leaf);
+    const Status seek(const char* key, const RID & rid,
+                      int & pageNo, BTreeNode* & node, int & pos);
+    const Status insertSplit(const char* key, const RID & rid, int child,
+                             vector<int> & path);
+
+    friend const Status createBTreeIndex(const string, const string, const int,
+                                         const int, const Datatype, const bool,
+                                         const int);
+    static const int bulkCompare(const char* a, const char* b, const void* arg);
+    const Status bulkLoad(const string & relName, const int sortPages);
+    const Status bulkAppend(vector< vector<BTreeNode> > & levels,
+                            vector<int> & nodeNos, const int level,
+                            const char* entry, const int left, const int right);
+    const Status newNode(vector<BTreeNode> & run, const int pageNo, const int level);
+    const Status writeRun(vector<BTreeNode> & run, const int pageNo);
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <map>
 #include "db.h"
 // define if debug output wanted
 //#define DEBUGBUF
@@ -21,11 +22,23 @@ class BufHashTbl
 private:
     int HTSIZE;
     hashBucket**  ht; // actual hash table
-    int	 hash(const File* file, const int pageNo); // returns value between 0 and HTSIZE-1
+    // while resizing, the table being emptied into ht a few buckets at a
+    // time, its size, and the number of its buckets emptied so far
+    hashBucket**  oldHt;
+    int OLDSIZE;
+    int moved;
+    int	 hash(const File* file, const int pageNo, const int size); // returns value between 0 and size-1
+    hashBucket*& chain(const File* file, const int pageNo); // chain holding (file,pageNo)
+    void moveBuckets(int cnt); // empty cnt more buckets of oldHt
 
 public:
     BufHashTbl(const int htSize);  // constructor
     ~BufHashTbl(); // destructor
+
+    // move the entries to a table of htSize buckets, without stopping:
+    // each later insert, lookup or remove moves a few buckets' worth
+    void resize(const int htSize);
+    const int size() const { return HTSIZE; }
 	
     // insert entry into hash table mapping (file,pageNo) to frameNo;
     // returns 0 if OK, HASHTBLERROR if an error occurred
@@ -42,7 +55,20 @@ public:
 };
 
 
+const int POOLCHUNK = 4096;	// most frames in a chunk of the pool
+
+// how the pages of the pool are allocated, or'ed together.  By default
+// each chunk is an anonymous mapping aligned to, and advised for,
+// transparent huge pages, faulted in (and zeroed) by the kernel as
+// frames are first used.
+const int POOLHUGETLB = 1;	// reserved huge pages, if enough are free
+const int POOLINTERLEAVE = 2;	// pages spread round-robin over NUMA nodes
+const int POOLPREFAULT = 4;	// fault every page in when allocated
+const int POOLTHP = 8;		// reported only: advised for transparent
+				// huge pages
+
 class BufMgr;  //forward declaration of BufMgr class 
+class LogMgr;
 
 // class for maintaining information about buffer pool frames
 class BufDesc {
@@ -55,6 +81,12 @@ private:
   bool 	dirty;	  // true if dirty;  false otherwise
   bool 	valid;   // true if page is valid
   bool  refbit;	 // has this buffer frame been reference recently
+  LSN	pageLSN; // LSN of the last logged update of the page, 0 if none
+  LSN	recLSN;  // LSN of the first logged update since the page was
+		 // last written, 0 if none
+  int	prevFrame; // neighbours on the list of frames of file, -1 at
+  int	nextFrame; // the ends
+  Page*	page;	 // the frame's page in its chunk of the pool
 
   void Clear() {  // initialize buffer frame for a new user
     	pinCnt = 0;
@@ -62,6 +94,7 @@ private:
 	pageNo = -1;
     	dirty = false;
 	valid = false;
+	pageLSN = recLSN = 0;
   };
 
   void Set(File* filePtr, int pageNum) { 
@@ -71,6 +104,7 @@ private:
       dirty = false;
       valid = true;
       refbit = true;
+      pageLSN = recLSN = 0;
   }
 
   BufDesc() {
@@ -82,12 +116,21 @@ private:
 struct BufStats
 {
   int accesses;    // Total number of accesses to buffer pool
+  int pins;        // Number of pages pinned by readPage and allocPage
   int diskreads;   // Number of pages read from disk (including allocs)
   int diskwrites;  // Number of pages written back to disk
+  int ckptWrites;  // Number of pages written by checkpoints
+  int moves;       // Number of pages moved out of retired frames
+  int mappedReads; // Number of pins served from file mappings
+  int tierHits;    // Number of misses served by the compressed tier
+  int tierMisses;  // Number of misses the compressed tier could not serve
+  int tierStores;  // Number of evicted pages kept in the compressed tier
 
   void clear()
     {
-      accesses = diskreads = diskwrites = 0;
+      accesses = pins = diskreads = diskwrites = 0;
+      ckptWrites = moves = mappedReads = 0;
+      tierHits = tierMisses = tierStores = 0;
     }
       
   BufStats()
@@ -101,33 +144,175 @@ class BufMgr
 {
 private:
   unsigned int 	 clockHand;
-  int   	 numBufs;    	// Number of pages in buffer pool
+  int   	 numBufs;    	// Number of frames in the chunks of the pool
+  int		 liveBufs;	// Number of frames pages may be read into
   BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
+  int		 tableCap;	// entries allocated in bufTable
+  int		 poolFlags;	// POOLHUGETLB, POOLINTERLEAVE, POOLPREFAULT
+
+  // the pool is made of chunks of up to POOLCHUNK frames, each a run of
+  // frames whose pages are one allocation; frames from liveBufs on are
+  // retired, and a chunk made of retired frames is freed once none of
+  // them holds a page
+  struct PoolChunk
+  {
+	Page*	pages;
+	int	firstFrame;
+	int	frames;
+	size_t	mapLen;		// bytes mapped at pages
+	int	backing;	// what the chunk got of POOLHUGETLB,
+				// POOLTHP, POOLINTERLEAVE, POOLPREFAULT
+  };
+  vector<PoolChunk> chunks;
+  map<const Page*, int> chunkAt; // first frame of each chunk, by its pages
   BufStats	 bufStats;	// buffer pool statistics
+  LogMgr*	 log;		// write-ahead log, NULL if none
+
+  // fuzzy checkpoint in progress: the pages of its dirty page table in
+  // (file, pageNo) order, and those still to be written from ckptNext
+  struct CkptPage
+  {
+	const File* file;
+	int	pageNo;
+  };
+  vector<CkptPage> ckptPages;
+  unsigned	 ckptNext;
+  int		 ckptRate;	// pages written per readPage/allocPage call
+  LSN		 ckptLSN;	// its LOG_CHECKPOINT record, 0 without a log
+  LSN		 ckptRedo;	// where redo starts once it ends
+
+  // second tier: compressed copies of pages evicted from the pool, each
+  // in an entry on a list of its file's entries and on a list from the
+  // most to the least recently stored
+  struct TierEntry
+  {
+	const File* file;
+	int	pageNo;
+	char*	data;		// the compressed page, NULL if the entry is free
+	int	len;
+	int	prev, next;	// neighbours by age; next links free entries
+	int	filePrev, fileNext; // neighbours among the file's entries
+  };
+  vector<TierEntry> tier;
+  BufHashTbl*	 tierIndex;	// (file, pageNo) to entry, NULL if no tier
+  int		 tierFree;	// first free entry, -1 if none
+  int		 tierNewest;	// -1 if the tier is empty
+  int		 tierOldest;
+  long		 tierBudget;	// bytes the tier may take
+  long		 tierUsed;	// bytes of its pages and entries
+
+  void tierStore(const int frame);   // keep a clean frame's page compressed
+  const bool tierLoad(const File* file, const int pageNo, Page* page);
+  void tierDrop(const int e);        // free an entry
+  void tierDropPage(const File* file, const int pageNo);
 
   const Status allocBuf(int & frame);   // allocate a free frame.  
+  const Status writeFrame(const int frame); // write a dirty frame, log first
+  const Status writeFrames(vector<int> & frames); // write dirty frames sorted
+  void linkFrame(const int frame);   // add a frame to its file's frames
+  void unlinkFrame(const int frame); // take a frame off its file's frames
   const void releaseBuf(int frame); // return unused frame to end of list
+  void addFrames(const int frames);  // add chunks of frames to the end of the pool
+  const Status retireFrame(const int frame); // move or evict a retired frame's page
+  void releaseChunks();		     // free chunks of empty retired frames
   void advanceClock()
   {
-	clockHand = (clockHand + 1) % numBufs;
+	clockHand = (clockHand + 1) % liveBufs;
+  }
+  const int frameOf(const Page* page) const // the frame holding a page
+  {
+	map<const Page*, int>::const_iterator it = chunkAt.upper_bound(page);
+	--it;
+	return it->second + (page - it->first);
   }
 
 
 public:
-  Page*	         bufPool;   // actual buffer pool
-
-  BufMgr(const int bufs);
+  BufMgr(const int bufs, const int flags = 0);
   ~BufMgr();
 
+  // Resize the pool to bufs frames while it is in use. Growing adds
+  // chunks of frames. Shrinking retires the frames from bufs on: each
+  // page in one is moved to a frame the clock gives up if it was
+  // referenced since the clock last passed it, else evicted, and a
+  // pinned one is dealt with when it is unpinned. The memory of a
+  // chunk is freed when all its frames are retired and empty, so the
+  // pool keeps up to POOLCHUNK-1 frames more than bufs. The hash
+  // table is resized a few buckets at a time, as it is used.
+  const Status resize(const int bufs);
+  const int getNumBufs() const { return liveBufs; } // frames in use
+  const int getPoolBufs() const { return numBufs; } // frames allocated
+
+  // the backing chunk got of POOLHUGETLB, POOLTHP, POOLINTERLEAVE and
+  // POOLPREFAULT, which may be less than was asked for: MAP_HUGETLB
+  // fails when too few huge pages are reserved, and mbind when the
+  // kernel has no NUMA support
+  const int getChunkCnt() const { return chunks.size(); }
+  const int getChunkBacking(const int chunk) const { return chunks[chunk].backing; }
+
   const Status readPage(File* file, const int PageNo, Page*& page);
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
+
+  // Pin a page only to read it. A page in the pool is pinned in its
+  // frame as by readPage; any other page of a plain file is pinned in
+  // place in a read-only mapping of the file, without taking a frame or
+  // copying it, and mapped is set. A mapped pin is released with
+  // unPinMapped, and the page must not be changed through it.
+  const Status readPageMapped(File* file, const int PageNo, Page*& page,
+                              bool & mapped);
+  const Status unPinMapped(File* file, const int PageNo);
   const Status allocPage(File* file, int& PageNo, Page*& page); 
                         // allocates a new, empty page 
   const Status flushFile(const File* file); // writing out all dirty pages of the file
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
+
+  // Begin a fuzzy checkpoint: take the dirty page table, the frames that
+  // are dirty, and log it with the open transaction if a log is attached.
+  // Those frames are then written in (file, pageNo) order, pagesPerCall
+  // of them each time readPage or allocPage is called, whether or not
+  // they are pinned; a page written since, or no longer in the pool, is
+  // skipped.  Once the last is written the end of the checkpoint is
+  // logged with its redo point, the earliest recLSN of the table, from
+  // which redoLog replays the log.  One begun while another runs
+  // replaces it.
+  const Status beginCheckpoint(const int pagesPerCall);
+
+  // write up to maxPages more pages of the checkpoint in progress
+  const Status checkpointStep(const int maxPages);
+  const bool inCheckpoint() const { return ckptNext < ckptPages.size(); }
+
+  // Keep pages evicted from the pool compressed in a second tier of at
+  // most bytes, 0 for none, dropping the pages stored longest ago to
+  // stay within it. A miss is served from the tier, which then drops
+  // the page, before it goes to the file.
+  void setTierBudget(const long bytes);
+  const long getTierUsed() const { return tierUsed; }
+
+  // drop the tier's copies of cnt pages of file from pageNo on, which
+  // File does whenever it writes, allocates or frees pages itself
+  void dropCached(const File* file, const int pageNo, const int cnt);
+
   void  printSelf();
 
+  // attach a write-ahead log, or detach it with NULL; the log previously
+  // attached is flushed first
+  const Status setLog(LogMgr* logMgr);
+  LogMgr* getLog() const { return log; }
+
+  // record that the page in a frame was changed by the log record
+  // ending at lsn, which makes the frame dirty at once rather than when
+  // it is unpinned; the frame is not written until the log is durable
+  // up to lsn.  redone is false for a page redo does not restore, such
+  // as a heap file header, which then does not hold back the redo point
+  void setPageLSN(const Page* page, const LSN lsn, const bool redone = true)
+  {
+	BufDesc & desc = bufTable[frameOf(page)];
+	desc.dirty = true;
+	desc.pageLSN = lsn;
+	if (redone && desc.recLSN == 0) desc.recLSN = lsn;
+  }
+
   const BufStats & getBufStats() const // get buffer pool usage
   {
 	return bufStats;
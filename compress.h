@@ -0,0 +1,22 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+// Page compression in the style of LZ4 block format: a sequence of
+// (literal run, back reference) pairs, each introduced by a token byte
+// whose high nibble is the literal count and low nibble the match
+// length minus MINMATCH; a nibble of 15 is continued in following
+// bytes of 255.  References are 2-byte little-endian back offsets.
+// The final pair has literals only.  Padded strings and runs of blanks
+// or zeroes, as found on heap file pages, shrink to a few bytes.
+
+const int MINMATCH = 4;
+
+// compress srcLen bytes into dst; returns the compressed length, or 0
+// if it would not fit in dstCap bytes
+int compressPage(const char* src, const int srcLen, char* dst, const int dstCap);
+
+// decompress srcLen bytes into dst; returns the number of bytes
+// produced, or -1 if the input is corrupt or would overflow dstCap
+int decompressPage(const char* src, const int srcLen, char* dst, const int dstCap);
+
+#endif
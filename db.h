@@ -5,6 +5,7 @@
 #include <functional>
 #include "error.h"
 #include <string.h>
+#include <vector>
 using namespace std;
 
 // define if debug output wanted
@@ -15,21 +16,70 @@ using namespace std;
 // forward class definition for db
 class DB;
 
+// location of a page of a compressed file
+struct PageExtent
+{
+  int	offset;  // byte offset in the unix file
+  short	length;  // stored bytes; PAGESIZE if stored uncompressed,
+                 // 0 if never written (reads as zeroes)
+  short	alloc;   // bytes reserved at offset
+};
+
+// byte counts of all file I/O
+struct IOStats
+{
+  long bytesRead;     // bytes read from unix files
+  long bytesWritten;  // bytes written to unix files
+
+  void clear()
+    {
+      bytesRead = bytesWritten = 0;
+    }
+
+  IOStats()
+    {
+      clear();
+    }
+};
+
+extern IOStats ioStats;
+
 // class definition for open files
 class File {
   friend class DB;
   friend class OpenFileHashTbl;
+  friend class BufMgr;
 
  public:
 
   Status allocatePage(int& pageNo);     // allocate a new page
+  const Status allocatePages(const int cnt,
+                             int& pageNo);  // allocate pageNo..pageNo+cnt-1
   const Status disposePage(const int pageNo);       // release space for a page
   const Status readPage(const int pageNo,
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status writePages(const int pageNo, const Page* const pages[],
+                          const int cnt);     // write to pageNo..pageNo+cnt-1
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
 
+  // pin a page in place in a read-only mapping of the file, mapping it,
+  // or mapping it again if it has grown and no page of it is pinned;
+  // BADPAGENO if the page lies beyond what can be mapped, UNIXERR if
+  // mmap fails
+  const Status mapPage(const int pageNo, Page*& pagePtr);
+  void unmapPage() { mapPins--; }   // release a pin of mapPage
+  // pass advice (MADV_*) about pages pageNo..pageNo+cnt-1 of the mapping
+  void adviseMap(const int pageNo, const int cnt, const int advice) const;
+
+  // false if the file was not closed cleanly before it was opened: pages
+  // were written and the process died before the close flushed the rest
+  const bool isClean() const { return !suspect; }
+  void markRepaired() { suspect = false; written = true; } // vouch for it
+
+  const string & getName() const { return fileName; }
+
   bool operator == (const File & other) const
     {
       return fileName == other.fileName;
@@ -40,7 +90,8 @@ class File {
   File(const string &fname);                   // initialize
   ~File();                  // deallocate file object
 
-  static const Status create(const string &fileName);
+  static const Status create(const string &fileName, const bool compressed,
+                             const bool direct);
   static const Status destroy(const string &fileName);
 
   const Status open();
@@ -51,6 +102,16 @@ class File {
   const Status intwrite(const int pageNo,
 		  const Page* pagePtr);       // internal file write
 
+  const Status rawread(const int offset, char* buf, const int len) const;
+  const Status rawwrite(const int offset, const char* buf, const int len);
+  const Status directread(const int pageNo, Page* pagePtr) const;
+  const Status directwrite(const int pageNo, const Page* pagePtr);
+  const Status readMap();              // load header state and page map
+  const Status markUnclean();          // note pages are being written
+  const Status writeMap();             // save page map of compressed file
+  const int allocSpace(const int len); // place len bytes of a compressed file
+  void dropCached(const int pageNo, const int cnt) const; // stale tier copies
+
 #ifdef DEBUGFREE
   void listFree();                      // list free pages
 #endif
@@ -58,6 +119,54 @@ class File {
   string fileName;                    // The name of the file
   int openCnt;                        // # times file has been opened
   int unixFile;                       // unix file stream for file
+
+  // Pages of a compressed file are stored at variable offsets, found
+  // through a page map that is kept in memory while the file is open
+  // and written to the file when it is closed.  Space that neither the
+  // map on disk nor an extent it lists takes up, such as an older map
+  // or the old extent of a page that grew, is found when the file is
+  // opened and reused for new extents and the next map.
+  struct Hole
+  {
+    int offset;
+    int length;
+  };
+  bool compressed;                    // true if pages are stored compressed
+  vector<PageExtent> extents;         // page map, indexed by page number
+  vector<Hole> holes;                 // free space below dataEnd, by offset
+  int dataEnd;                        // end of the used part of the file
+  bool mapDirty;                      // page map changed since open
+
+  // The header page carries a clean-shutdown marker.  It is set, and
+  // synced, before the first page is written after the file is opened,
+  // and cleared only once the last close has flushed and synced every
+  // page, so a file found marked was open for writing in a crash.
+  bool written;                       // pages written since open
+  bool suspect;                       // marked when opened
+
+  // A direct file is read and written with O_DIRECT, bypassing the
+  // kernel's page cache.  Each page fills a slot of stride bytes on
+  // disk, PAGESIZE unless the device's direct I/O blocks are larger.
+  // A page whose slot is larger, or that is not in memory aligned for
+  // direct I/O, goes through the bounce buffer.
+  bool direct;                        // opened with O_DIRECT
+  int stride;                         // bytes from one page to the next
+  int memAlign;                       // alignment direct I/O memory needs
+  char* bounce;                       // stride bytes so aligned, or NULL
+
+  // first of the buffer pool frames holding pages of the file, which
+  // BufMgr links through their descriptors; -1 if none
+  mutable int firstFrame;
+  // first of the compressed copies of its pages that BufMgr keeps in
+  // its second tier, linked through their entries; -1 if none
+  mutable int firstCached;
+
+  // A plain file may be mapped read-only, shared, so that pages are read
+  // in place; writes through the unix file show in the mapping.  It is
+  // unmapped on the last close.
+  char* mapBase;                      // the mapping, NULL if none
+  int mapPages;                       // pages mapped
+  int mapPins;                        // pins of mapPage outstanding
 };
 
 class BufMgr;
@@ -103,7 +212,9 @@ class DB {
   DB();                                 // initialize open file table
   ~DB();                                // clean up any remaining open files
 
-  const Status createFile(const string & fileName) ;  // create a new file
+  const Status createFile(const string & fileName,
+                          const bool compressed = false,
+                          const bool direct = false) ;  // create a new file
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
   const Status openFile(const string & fileName, File* & file);  // open a file
@@ -120,6 +231,11 @@ typedef struct {
   int nextFree;                         // page # of next page on free list
   int firstPage;                        // page # of first page in file
   int numPages;                         // total # of pages in file
+  int compressed;                       // nonzero if pages are compressed
+  int mapOffset;                        // byte offset of page map, if compressed
+  int dataEnd;                          // end of pages and map, if compressed
+  int unclean;                          // nonzero while open for writing
+  int stride;                           // bytes per page slot if direct, else 0
 } DBPage;
 
 #endif
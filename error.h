@@ -31,6 +31,7 @@ enum Status {
 // HeapFile errors
 
        BADRID, BADRECPTR, BADSCANPARM, BADSCANID, SCANTABFULL, FILEEOF, FILEHDRFULL,
+       BADLOGREC,
 
 // Index errors
  
@@ -0,0 +1,163 @@
+#ifndef FIXEDPAGE_H
+#define FIXEDPAGE_H
+
+#include <iostream>
+#include "page.h"
+using namespace std;
+
+// Class definition for a data page holding fixed-length records.
+// The record length is a template parameter, so the number of slots
+// and every record address are compile-time arithmetic.  Instead of
+// a slot_t per record the page keeps a validity bitmap, one bit per
+// slot.  Records never move, so deletions do not compact anything.
+//
+// The last 18 bytes (seq, lsn, nextPage, curPage) are laid out exactly
+// as in Page, so code that only follows the page chain can treat any
+// data page as a Page.
+
+const unsigned FIXEDHDRSIZE = 3*sizeof(short) + sizeof(LSN) + 2*sizeof(int);
+
+template <int RECLEN>
+class FixedPage {
+public:
+    enum {
+        SLOTS = ((PAGESIZE - FIXEDHDRSIZE) * 8) / (RECLEN * 8 + 1),
+        MAPSIZE = (SLOTS + 7) / 8
+    };
+
+private:
+    char	data[PAGESIZE - FIXEDHDRSIZE]; // records, then the bitmap
+    short	recCnt;   // number of valid records on the page
+    short	slotHigh; // one past the highest slot ever used
+    unsigned short seq; // position in the file's page chain, as in Page
+    LSN		lsn;      // LSN of the last logged update, as in Page
+    int		nextPage; // forwards pointer
+    int		curPage;  // page number of current pointer
+
+    unsigned char* map() { return (unsigned char*)&data[SLOTS * RECLEN]; }
+    const unsigned char* map() const
+    { return (const unsigned char*)&data[SLOTS * RECLEN]; }
+
+    bool isValid(const int slotNo) const
+    {
+        return (slotNo >= 0 && slotNo < slotHigh &&
+                (map()[slotNo >> 3] & (1 << (slotNo & 7))));
+    }
+
+public:
+    void init(const int pageNo)
+    {
+        memset(map(), 0, MAPSIZE);
+        recCnt = 0;
+        slotHigh = 0;
+        lsn = 0;
+        nextPage = -1;
+        curPage = pageNo;
+    }
+
+    void dumpPage() const
+    {
+        cout << "curPage = " << curPage << ", nextPage = " << nextPage
+             << "\nrecLen = " << RECLEN << ", slots = " << SLOTS
+             << ", recCnt = " << recCnt << ", slotHigh = " << slotHigh << endl;
+    }
+
+    const Status getNextPage(int& pageNo) const
+    {
+        pageNo = nextPage;
+        return OK;
+    }
+
+    const Status setNextPage(const int pageNo)
+    {
+        nextPage = pageNo;
+        return OK;
+    }
+
+    const short getFreeSpace() const
+    {
+        return (SLOTS - recCnt) * RECLEN;
+    }
+
+    // inserts a new record (rec) into the first free slot
+    const Status insertRecord(const Record & rec, RID& rid)
+    {
+        if (rec.length != RECLEN) return INVALIDRECLEN;
+        if (recCnt == SLOTS) return NOSPACE;
+
+        // reuse a hole left by a deletion before extending slotHigh
+        int i = 0;
+        if (recCnt < slotHigh)
+            while (isValid(i)) i++;
+        else
+            i = slotHigh;
+
+        map()[i >> 3] |= (1 << (i & 7));
+        memcpy(&data[i * RECLEN], rec.data, RECLEN);
+        recCnt++;
+        if (i == slotHigh) slotHigh++;
+
+        rid.pageNo = curPage;
+        rid.slotNo = i;
+        return OK;
+    }
+
+    // delete the record with the specified rid
+    const Status deleteRecord(const RID & rid)
+    {
+        if (!isValid(rid.slotNo)) return INVALIDSLOTNO;
+
+        map()[rid.slotNo >> 3] &= ~(1 << (rid.slotNo & 7));
+        recCnt--;
+
+        // trailing holes need not be visited by scans
+        while (slotHigh > 0 && !isValid(slotHigh - 1)) slotHigh--;
+        return OK;
+    }
+
+    // returns RID of first record on page
+    const Status firstRecord(RID& firstRid) const
+    {
+        for (int i = 0; i < slotHigh; i++)
+            if (isValid(i))
+            {
+                firstRid.pageNo = curPage;
+                firstRid.slotNo = i;
+                return OK;
+            }
+        return NORECORDS;
+    }
+
+    // returns RID of next record on the page
+    const Status nextRecord(const RID & curRid, RID& nextRid) const
+    {
+        for (int i = curRid.slotNo + 1; i < slotHigh; i++)
+            if (isValid(i))
+            {
+                nextRid.pageNo = curPage;
+                nextRid.slotNo = i;
+                return OK;
+            }
+        return ENDOFPAGE;
+    }
+
+    // returns pointer to record with RID rid
+    const Status getRecord(const RID & rid, Record & rec)
+    {
+        if (!isValid(rid.slotNo)) return INVALIDSLOTNO;
+        rec.data = &data[rid.slotNo * RECLEN];
+        rec.length = RECLEN;
+        return OK;
+    }
+};
+
+// Fixed-length layouts are compiled for every record length that is a
+// multiple of FIXEDRECALIGN up to MAXFIXEDRECLEN. Returns NULL for
+// other lengths, in which case the file keeps using slotted pages.
+
+const int FIXEDRECALIGN = 4;
+const int MAXFIXEDRECLEN = 256;
+
+const PageOps* fixedPageOps(const int recLen);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include "heapfile.h"
+
+// An extendible hash index maps the values of one attribute (offset,
+// length, type) of a heap file's records to their RIDs, for equality
+// lookups.  It lives in its own file: a header page, directory pages
+// and bucket pages, all read through the buffer pool.
+//
+// The directory has 2^globalDepth slots, DIRSLOTS to a page, and slot
+// h mod 2^globalDepth holds the bucket of the keys that hash to h.  A
+// bucket of localDepth d is shared by the 2^(globalDepth-d) slots that
+// agree on the low d bits of the hash.  A full bucket is split on its
+// next hash bit, doubling the directory first if localDepth has reached
+// globalDepth.  The page numbers of the directory pages are listed on
+// map pages, DIRSLOTS to a page, and kept in memory while the index is
+// open, so a lookup reads one directory page and one bucket.
+//
+// A bucket whose entries all have the same hash cannot be split, so
+// once it is full, entries with that hash go on overflow pages chained
+// from it; a bucket with a chain is split like any other when an entry
+// with another hash finds no room, and its entries are redistributed
+// over the two chains.  Growing the directory past MAXGLOBALDEPTH is
+// DIROVERFLOW, and an overflow page that cannot be allocated is
+// BUCKETFULL.  Deletes never merge buckets or free overflow pages.
+
+const int MAXHASHKEYLEN = 128;  // longest STRING key
+const int DIRSLOTS = PAGESIZE / sizeof(int);
+const int MAXGLOBALDEPTH = 20;
+const int MAXMAPPAGES = (1 << MAXGLOBALDEPTH) / DIRSLOTS / DIRSLOTS;
+
+struct HashHdrPage
+{
+  char		indexName[MAXNAMESIZE]; // name of index file
+  char		relName[MAXNAMESIZE];   // heap file the index was built on
+  int		offset;		// byte offset of key attribute within record
+  int		length;		// length of key attribute
+  Datatype	type;		// datatype of key attribute
+  int		unique;		// nonzero if keys may not repeat
+  int		globalDepth;	// directory has 2^globalDepth slots
+  int		entryCnt;	// number of entries
+  int		bucketCnt;	// number of buckets
+  int		overflowCnt;	// number of overflow pages in their chains
+  int		dirPageCnt;	// number of directory pages
+  int		mapPages[MAXMAPPAGES]; // pages listing the directory pages
+};
+
+// Bucket page: keyCnt entries of the key's hash, the key padded to a
+// multiple of 4 bytes and a RID.  Overflow pages have the same layout.
+
+struct HashBucketPage
+{
+  short		localDepth;	// low hash bits shared by all entries
+  short		keyCnt;		// entries in use
+  int		overflow;	// next page of the bucket's chain, -1 if none
+  char		data[PAGESIZE - 2*sizeof(short) - sizeof(int)];
+};
+
+// create an index named indexName over attribute (offset, length, type)
+// of the records of heap file relName, inserting the records it
+// already holds.  With unique set, a repeated key is NONUNIQUEENTRY.
+const Status createHashIndex(const string indexName, const string relName,
+                             const int offset, const int length,
+                             const Datatype type, const bool unique = false);
+const Status destroyHashIndex(const string indexName);
+
+class HashIndex {
+public:
+
+    HashIndex(const string & name, Status & status);
+    ~HashIndex();
+
+    // add entry (key, rid), where key points at length bytes
+    const Status insertEntry(const char* key, const RID & rid);
+
+    // remove entry (key, rid); RECNOTFOUND if it is not in the index
+    const Status deleteEntry(const char* key, const RID & rid);
+
+    // scan the entries whose key equals filter; op must be EQ
+    const Status startScan(const char* filter, const Operator op);
+
+    // return RID of next matching entry; NOMORERECS at the end
+    const Status scanNext(RID & outRid);
+
+    const Status endScan(); // terminate the scan
+
+    const HashHdrPage & getHeader() const // get index parameters and counts
+    {
+	return *headerPage;
+    }
+
+private:
+    File*	filePtr;	// underlying DB File object
+    HashHdrPage* headerPage;	// pinned index header page
+    int		headerPageNo;	// page number of header page
+    bool	hdrDirtyFlag;	// true if header page has been updated
+    int		keySize;	// key bytes in an entry, length padded to 4
+    int		bucketCap;	// entries per bucket
+    vector<int>	dirPages;	// directory pages in slot order
+
+    // scan state: the bucket being scanned stays pinned
+    int		curPageNo;	// bucket of the scan, -1 once it has ended
+    HashBucketPage* curPage;
+    int		curEntry;	// next entry of curPage to look at
+    unsigned	scanHash;	// hash of scanKey
+    char	scanKey[MAXHASHKEYLEN];
+
+    const int entrySize() const { return sizeof(unsigned) + keySize + sizeof(RID); }
+    char* entry(HashBucketPage* bucket, const int i) const
+    { return &bucket->data[i * entrySize()]; }
+
+    const unsigned hashKey(const char* key) const;
+    const bool keyEqual(const char* a, const char* b) const;
+
+    const Status readBucket(const unsigned hash, int & pageNo,
+                            HashBucketPage* & bucket);
+    const Status setSlot(const int slot, const int pageNo);
+    const Status addDirPage(const int pageNo);
+    const Status doubleDirectory();
+    const Status chainEntry(int & pageNo, HashBucketPage* & bucket,
+                            const char* e, vector<int> & spare);
+    const Status splitBucket(const unsigned hash, const int pageNo,
+                             HashBucketPage* bucket);
+};
+
+#endif
@@ -21,29 +21,180 @@ const unsigned MAXNAMESIZE = 50;
 
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
+enum PageLayout { SLOTTED, FIXED, PAX };     // data page layouts
+
+// description of an attribute of the records in a heap file
+struct AttrDesc
+{
+  int		offset;		// byte offset of attribute within record
+  int		length;		// length of attribute
+  Datatype	type;		// datatype of attribute
+};
+
+const int MAXATTRS = 8;
+
+// a piece of a record a scan projects onto
+struct ProjAttr
+{
+  int		offset;		// byte offset of the piece within record
+  int		length;		// length of the piece
+};
+
+const int MAXPROJ = 16;		// pieces in a projection
+const int MAPAHEAD = 64;	// pages a mapped scan asks to be read ahead
 
 struct FileHdrPage
 {
   char		fileName[MAXNAMESIZE];   // name of file
   int		firstPage;	// pageNo of first data page in file
   int		lastPage;	// pageNo of last data page in file
-  int		pageCnt;	// number of pages
+  int		pageCnt;	// number of data pages
   int		recCnt;		// record count
+  int		recLen;		// fixed record length, 0 if records vary
+  int		layout;		// PageLayout of the data pages
+  int		attrCnt;	// number of declared attributes
+  AttrDesc	attrs[MAXATTRS]; // declared attributes (the file's schema)
+  int		zoneDirFirst;	// first zone map directory page, -1 if none
+  int		zoneDirLast;	// last zone map directory page, -1 if none
+  int		bloomAttr;	// attribute with per-page Bloom filters, -1 if none
+  int		bloomBytes;	// size of each page's Bloom filter
 };
 
+// range of values a numeric attribute takes on the records of one data
+// page; lo > hi if no record on the page has the attribute
+union ZoneVal { int i; float f; };
+struct Zone
+{
+  ZoneVal	lo;
+  ZoneVal	hi;
+};
+
+struct ScanStats
+{
+  int pagesRead;     // data pages read by the scan
+  int pagesSkipped;  // data pages skipped by zone maps or Bloom filters
+
+  void clear()
+    {
+      pagesRead = pagesSkipped = 0;
+    }
+
+  ScanStats()
+    {
+      clear();
+    }
+};
+
+
+// compare two values of an attribute of the given length and type:
+// negative, zero or positive as a is less than, equal to or greater
+// than b.  STRING values compare like the strncmp of a filtered scan.
+const int attrCompare(const char* a, const char* b, const int length,
+                      const Datatype type);
+
+// hash a value of an attribute so that values attrCompare finds equal
+// hash alike; different seeds give independent hash functions
+const unsigned attrHash(const char* key, const int length,
+                        const Datatype type, const unsigned seed = 0);
+
+// called by HeapFile::visitRecords with each record and its index i in
+// the caller's RID list; a status other than OK ends the visit
+typedef const Status (*RecordVisitor)(const int i, const Record & rec, void* arg);
 
 // class definition of heapFile
+// create a heap file; a positive recLen declares that every record has
+// exactly that length, letting the file use fixed-length pages.  Pages
+// of a compressed file are compressed on disk and plain in the buffer pool.
+// A direct file bypasses the kernel's page cache (see DB::createFile).
+const Status createHeapFile(const string fileName, const int recLen = 0,
+                            const bool compressed = false,
+                            const bool direct = false);
+
+const int BLOOMBYTES = 16;  // default size of a page's Bloom filter
+const int BLOOMHASHES = 4;  // bits set in a Bloom filter per key
+
+// create a heap file with a declared schema; if layout is PAX the
+// attribute values are stored column by column.  bloomAttr names a
+// STRING attribute to keep per-page Bloom filters of bloomBytes on.
+const Status createHeapFile(const string fileName, const int recLen,
+                            const AttrDesc attrs[], const int attrCnt,
+                            const PageLayout layout,
+                            const int bloomAttr = -1,
+                            const int bloomBytes = BLOOMBYTES,
+                            const bool compressed = false,
+                            const bool direct = false);
+const Status destroyHeapFile(const string fileName);
+
+// what repairHeapFiles did to one file
+struct FileRepair
+{
+  string fileName;
+  Status status;     // OK, or the error that stopped the check
+  bool checked;      // false if the file had been closed cleanly
+  int pagesRead;     // data pages read
+  int cutAfter;      // page whose nextPage link was cut, -1 if none
+  int hdrFixes;      // header fields corrected: lastPage, pageCnt, recCnt,
+                     // zoneDirLast
+
+  FileRepair()
+    {
+      status = OK;
+      checked = false;
+      pagesRead = hdrFixes = 0;
+      cutAfter = -1;
+    }
+};
+
+// Check the heap files among fileNames that were not closed cleanly,
+// up to threads of them at once, and repair them: the page chain is cut
+// before the first page that was never written, the header counters
+// are recounted from the pages kept and the zone map directory is
+// rebuilt.  Files closed cleanly cost one header read.  Meant for
+// restart, before any of the files is opened; repairs gets an entry
+// per file, in order.
+const Status repairHeapFiles(const vector<string> & fileNames,
+                             const int threads, vector<FileRepair> & repairs);
+
+// what redoLog did
+struct LogRedo
+{
+  LSN redoFrom;      // LSN replay started from, 0 without a checkpoint
+  LSN logEnd;        // end of the log, where a torn tail was cut
+  int records;       // update records replayed
+  int applied;       // of which were missing from their page
+  int missing;       // of which named a file that cannot be opened
+
+  LogRedo()
+    {
+      redoFrom = logEnd = 0;
+      records = applied = missing = 0;
+    }
+};
+
+// Replay the write-ahead log in unix file logName after a crash: the
+// log is cut after its last whole record, and every update record from
+// the redo point of the last checkpoint that ended is applied to its
+// page unless the page's LSN shows it already holds it.  Pages are
+// read and written through File directly, so this is meant for
+// restart, before repairHeapFiles and before the log is opened again.
+const Status redoLog(const string & logName, LogRedo & redo);
+
 class HeapFile {
 protected:
    File* 	filePtr;        // underlying DB File object
    FileHdrPage*  headerPage;	// pinned file header page in buffer pool
    int		headerPageNo;	// page number of header page
    bool		hdrDirtyFlag;   // true if header page has been updated
+   const PageOps* pageOps;	// record operations for the file's page layout
 
    Page* 	curPage;	// data page currently pinned in buffer pool
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
    RID   	curRec;         // rid of last record returned
+   char		recBuf[PAGESIZE]; // records assembled by layouts that split them
+
+   // stamp page and the header page with the LSN of their update
+   void logged(Page* page, const LSN lsn);
 
 public:
 
@@ -56,8 +207,25 @@ public:
   // return number of records in file
   const int getRecCnt() const;
 
+  // return number of data pages in file
+  const int getPageCnt() const;
+
   // given a RID, read record from file, returning pointer and length
   const Status getRecord(const RID &rid, Record & rec);
+
+  // read the records of rids[0..cnt), pinning each page once, and copy
+  // them into buf (bufLen bytes), setting recs[i] to the record of
+  // rids[i]; INSUFMEM if they do not fit
+  const Status getRecords(const RID rids[], const int cnt, Record recs[],
+                          char* buf, const int bufLen);
+
+  // call visit on the records of rids[0..cnt) in page order, pinning
+  // each page once; the record is good until visit returns
+  const Status visitRecords(const RID rids[], const int cnt,
+                            RecordVisitor visit, void* arg);
+
+private:
+  void pageOrder(const RID rids[], const int cnt, vector<int> & order) const;
 };
 
 
@@ -76,6 +244,21 @@ public:
                            const char* filter, 
                            const Operator op);
 
+    // start a scan for records with attribute op filter, op LT or LTE
+    // (GT or GTE if descending), that reads the pages in order of the
+    // lowest (highest) value their zone maps allow and ends at the
+    // first page that cannot hold a match.  The filter value is read
+    // as the scan goes, so it may be tightened between calls to
+    // scanNext.  Records added once the scan has started may be
+    // missed.  Without zone maps of the attribute this is startScan.
+    // BADSCANPARM if the scan has already returned a record
+    const Status startOrderedScan(const int offset,
+                                  const int length,
+                                  const Datatype type,
+                                  const char* filter,
+                                  const Operator op,
+                                  const bool descending);
+
     const Status endScan(); // terminate the scan
     const Status markScan(); // save current position of scan
     const Status resetScan(); // reset scan to last marked location
@@ -86,12 +269,50 @@ public:
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
+    // project the records of the scan onto pieces attrs[0..cnt), packed
+    // one after another in that order; cnt 0 drops the projection.
+    // BADSCANPARM if a piece is malformed, there are more than MAXPROJ
+    // or they add up to more than a page
+    const Status setProjection(const ProjAttr attrs[], const int cnt);
+
+    const int getProjLength() const // bytes of a projected record
+    {
+	return projLen;
+    }
+
+    // copy the projection of the current record into out, where it stays
+    // good after the page is unpinned; INVALIDRECLEN if the record is
+    // too short to hold a piece
+    const Status getProjected(char* out);
+
+    // copy the projections of up to maxRecs more records of the scan into
+    // out, getProjLength() bytes apart, and their RIDs into rids unless
+    // it is NULL; records too short for the projection are skipped.  cnt
+    // is set to the number copied; FILEEOF once there are none
+    const Status scanProjected(char* out, const int maxRecs, int & cnt,
+                               RID* rids = NULL);
+
     // delete current record 
     const Status deleteRecord();
 
     // marks current page of scan dirty
     const Status markDirty();
 
+    // read the pages the scan goes on to, from the next, in place in a
+    // mapping of the file rather than copied into the buffer pool (see
+    // BufMgr::readPageMapped), advising the kernel to read ahead.  The
+    // records returned must not be changed before markDirty is called;
+    // deleteRecord and markDirty move the page into a frame first.
+    void setMapped(const bool on)
+    {
+	mapped = on;
+    }
+
+    const ScanStats & getScanStats() const // get page counts of the scan
+    {
+	return scanStats;
+    }
+
 private:
     int   offset;            // byte offset of filter attribute
     int   length;            // length of filter attribute
@@ -106,7 +327,38 @@ private:
     int   markedPageNo;	// page number of pinned page
     RID   markedRec;         // rid of last record returned
 
-    const bool matchRec(const Record & rec) const;
+    // Zone maps or Bloom filters of the filter attribute, one per data
+    // page in chain order, loaded by startScan if the file keeps them
+    vector<int>  zonePages;  // page numbers
+    vector<Zone> zones;      // zone of each page
+    vector<unsigned char> blooms; // Bloom filter of each page
+    int   filterProbes[BLOOMHASHES]; // Bloom filter bits of the filter value
+    int   zoneIdx;           // index of the last page looked up
+    vector<int> ordered;     // ordered scan: indexes of zonePages to read
+    int   orderIdx;          // position in ordered of the current page
+    int   coveredPage;       // last page markDirty opened the zones of
+    ScanStats scanStats;
+
+    bool  mapped;            // pages are pinned through the file mapping
+    bool  curMapped;         // curPage is in the file mapping
+    int   adviseFrom;        // first page last advised to be read ahead,
+                             // -1 until the scan's first mapped page
+
+    vector<ProjAttr> proj;   // projection, empty if none
+    int   projLen;           // bytes of a projected record
+    int   projLo, projHi;    // span of the record the pieces lie in
+    bool  projDone;          // scanProjected reached the end of the scan
+
+    const Status pinCurPage(const int pageNo);
+    const Status unpinCurPage();
+    const Status pinCurInFrame();
+    const bool pageMayMatch(const int k) const;
+    const int skipPages(const int nextPageNo);
+    const int nextOrderedPage();
+
+    // attr points at the filter attribute of a record, or is NULL if
+    // the record is too short to hold it
+    const bool matchRec(const char* attr) const;
 };
 
 
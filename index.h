@@ -0,0 +1,35 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include "heapfile.h"
+
+// Inserts an entry for every record of heap file relName into index,
+// one record at a time, skipping records too short to hold the key
+// attribute (offset, length).  Index is any index class with
+// insertEntry(const char* key, const RID & rid).
+
+template <class Index>
+const Status loadIndex(Index & index, const string & relName,
+                       const int offset, const int length)
+{
+    Status status;
+    RID rid;
+    Record rec;
+
+    HeapFileScan scan(relName, status);
+    if (status != OK) return status;
+    status = scan.startScan(0, 0, STRING, NULL, EQ);
+    if (status != OK) return status;
+
+    while ((status = scan.scanNext(rid)) == OK)
+    {
+        status = scan.getRecord(rec);
+        if (status != OK) return status;
+        if (offset + length > rec.length) continue;
+        status = index.insertEntry((char*)rec.data + offset, rid);
+        if (status != OK) return status;
+    }
+    return (status == FILEEOF) ? OK : status;
+}
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include "heapfile.h"
+#include "sort.h"
+
+// A HashJoin returns the pairs of records of two heap files whose join
+// attributes are equal, in no particular order.  The file with fewer
+// pages is the build side: its records are loaded into a hash table in
+// a workspace of the budget's pages and the other file, the probe
+// side, is scanned once against it.
+//
+// A build side too large for the workspace is partitioned, hybrid
+// style, on a hash of the join attribute into temporary heap files.
+// Partition 0 is sized to stay in the workspace and joined while the
+// probe side is partitioned; every other partition gets an open heap
+// file (two frames) on each side and is sized to fit the workspace
+// when its turn comes.  A partition still too large is partitioned
+// again with another hash function, down to MAXJOINLEVEL levels.  One
+// that kept more than 3/4 of the pages it was split from holds too many
+// equal keys for partitioning to help, so it is instead joined a
+// workspace at a time, scanning its probe side once per workspace.
+// Records too short to hold the join attribute join with nothing.
+
+const int MAXJOINLEVEL = 16;
+
+struct JoinStats
+{
+  int buildRecs;  // records read from the build (right, inner) side
+  int probeRecs;  // records read from the probe (left, outer) side
+  int partitions; // temporary files written: partition pairs, groups
+  int spillRecs;  // records written to temporary files
+  int passes;     // probe side scans against a workspace, group scans
+  int results;    // pairs returned
+
+  void clear()
+    {
+      buildRecs = probeRecs = partitions = spillRecs = passes = results = 0;
+    }
+
+  JoinStats()
+    {
+      clear();
+    }
+};
+
+class HashJoin {
+public:
+
+    // join heap files leftName and rightName on leftAttr = rightAttr in
+    // a budget of maxFrames buffer pool frames; ATTRTYPEMISMATCH if the
+    // attributes differ in type or length, BADSCANPARM if one is
+    // malformed, INSUFMEM if maxFrames is below 8
+    HashJoin(const string & leftName, const AttrDesc & leftAttr,
+             const string & rightName, const AttrDesc & rightAttr,
+             const int maxFrames, Status & status);
+    ~HashJoin();
+
+    // return the next pair of joining records, good until the next
+    // call; FILEEOF after the last one
+    const Status next(Record & leftRec, Record & rightRec);
+
+    const JoinStats & getJoinStats() const // get record and partition counts
+    {
+	return joinStats;
+    }
+
+private:
+    // a pair of files to join; the input files are level 0
+    struct JoinTask
+    {
+	string	buildName;
+	string	probeName;
+	int	level;
+	int	parentPages;	// build pages of the pair it was split from
+	bool	temp;		// partition files, destroyed once joined
+    };
+
+    string	leftName;
+    AttrDesc	attr;		// build side attribute
+    AttrDesc	probeAttr;
+    bool	buildLeft;	// the left file is the build side
+    int		maxFrames;
+    JoinStats	joinStats;
+
+    // workspace: a chained hash table of build records.  An entry is
+    // the offset of the next entry in its chain (-1 at the end), the
+    // hash, the record length and the record padded to 4 bytes.
+    vector<char> work;
+    vector<int>	table;		// first entry of each chain, -1 if none
+    int		workUsed;	// bytes of work in use
+
+    vector<JoinTask> tasks;	// pairs still to be joined
+    JoinTask	task;		// pair being joined
+    int		taskPages;	// build pages of task
+    bool	done;		// no pairs left
+
+    // build side of the current pair, when joined a workspace at a time
+    HeapFileScan* buildScan;	// NULL in partition mode
+    bool	buildPending;	// current build record did not fit yet
+    bool	buildDone;
+
+    // partition mode: files of partition p on each side, "" if none
+    int		partCnt;	// 0 when not partitioning
+    int		memShare;	// of 1024 hash values, those of partition 0
+    bool	memSpilled;	// partition 0 outgrew the workspace
+    vector<string> buildParts;
+    vector<string> probeParts;
+    vector<int>	partRecs;	// build records of each partition
+    vector<InsertFileScan*> partScans;
+
+    // probe state: current probe record and the next entry of its chain
+    HeapFileScan* probeScan;
+    Record	probeRec;
+    unsigned	probeHash;
+    int		match;		// next entry to look at, -1 if none
+
+    const int partOf(const char* key) const;
+    void resetWork(const int pages);
+    const bool addEntry(const Record & rec, const unsigned hash);
+
+    const Status startTask();
+    const Status endTask();
+    const Status loadChunk();
+    const Status startProbe();
+    const Status endProbe();
+    const Status partitionBuild(const int buildPages);
+    const Status openPart(string & partName, InsertFileScan* & partScan);
+    const Status spillEntries(InsertFileScan* partScan);
+    void closeParts();
+};
+
+// A SortMergeJoin returns the pairs of records of two heap files whose
+// join attributes are equal, in the attribute's order.  Each side is
+// read through a SortedFile, which streams a file found already in
+// order and sorts any other in 3/8 of the budget.  The right records of
+// a key are collected once as a group and paired with every left record
+// of that key, so neither input is read twice.  A group larger than the
+// rest of the budget is written to a temporary heap file instead, which
+// is scanned once for each left record of the key.
+
+class SortMergeJoin {
+public:
+
+    // join heap files leftName and rightName on leftAttr = rightAttr in
+    // a budget of maxFrames buffer pool frames; ATTRTYPEMISMATCH if the
+    // attributes differ in type or length, BADSCANPARM if one is
+    // malformed, INSUFMEM if maxFrames is below 16
+    SortMergeJoin(const string & leftName, const AttrDesc & leftAttr,
+                  const string & rightName, const AttrDesc & rightAttr,
+                  const int maxFrames, Status & status);
+    ~SortMergeJoin();
+
+    // return the next pair of joining records, good until the next
+    // call; FILEEOF after the last one
+    const Status next(Record & leftRec, Record & rightRec);
+
+    const JoinStats & getJoinStats() const // get record and group counts
+    {
+	return joinStats;
+    }
+
+    // get the run counts of sorting one side, and whether it was in order
+    const SortStats & getSortStats(const bool leftSide) const
+    {
+	return (leftSide ? left : right)->getSortStats();
+    }
+
+private:
+    string	rightName;
+    AttrDesc	leftAttr;
+    AttrDesc	rightAttr;
+    SortedFile*	left;
+    SortedFile*	right;
+    JoinStats	joinStats;
+    bool	done;		// no pairs left
+
+    Record	leftRec;	// current left record
+    bool	haveLeft;
+    Record	rightRec;	// first right record past the group
+    bool	haveRight;
+    bool	rightDone;	// right side exhausted
+
+    // the group of right records of key groupKey, in memory as a
+    // length and the record padded to 4 bytes, or in file groupName
+    bool	inGroup;	// pairing leftRec with the group
+    vector<char> groupKey;
+    vector<char> group;
+    vector<int>	groupRecs;	// offsets of the records in group
+    int		groupCap;	// bytes the group may take in memory
+    unsigned	groupPos;	// next record of group for leftRec
+    string	groupName;	// spilled group, "" if in memory
+    HeapFileScan* groupScan;	// scan of groupName for leftRec
+
+    const char* leftKey() const { return (char*) leftRec.data + leftAttr.offset; }
+    const char* rightKey() const { return (char*) rightRec.data + rightAttr.offset; }
+
+    const Status advanceLeft();
+    const Status advanceRight();
+    const Status collectGroup();
+    const Status spillGroup(InsertFileScan* & groupIns);
+    void endGroup();
+};
+
+// An IndexJoin returns the pairs of records of an outer heap file and
+// the inner heap file of an index whose join attributes are equal.  It
+// scans the outer file once and looks each record's attribute up in the
+// index, a BTreeIndex or HashIndex, fetching the inner records by RID,
+// so inner records that join with nothing are never read.
+
+template <class Index>
+class IndexJoin {
+public:
+
+    // join heap file outerName on outerAttr with the file indexed by
+    // index indexName; ATTRTYPEMISMATCH if the index is on an attribute
+    // of another type or length
+    IndexJoin(const string & outerName, const AttrDesc & outerAttr_,
+              const string & indexName, Status & status)
+        : outerAttr(outerAttr_), outerScan(NULL), index(NULL), inner(NULL),
+          scanning(false)
+    {
+	index = new Index(indexName, status);
+	if (status != OK) return;
+	if (index->getHeader().type != outerAttr.type ||
+	    index->getHeader().length != outerAttr.length)
+	{
+	    status = ATTRTYPEMISMATCH;
+	    return;
+	}
+	inner = new HeapFile(index->getHeader().relName, status);
+	if (status != OK) return;
+	outerScan = new HeapFileScan(outerName, status);
+	if (status != OK) return;
+	status = outerScan->startScan(0, 0, STRING, NULL, EQ);
+    }
+
+    ~IndexJoin()
+    {
+	delete outerScan;
+	delete inner;
+	delete index;
+    }
+
+    // return the next pair of joining records, good until the next
+    // call; FILEEOF after the last one
+    const Status next(Record & outerRec_, Record & innerRec)
+    {
+	Status status;
+	RID rid;
+
+	while (true)
+	{
+	    if (scanning)
+	    {
+		status = index->scanNext(rid);
+		if (status == OK)
+		{
+		    if ((status = inner->getRecord(rid, innerRec)) != OK) return status;
+		    joinStats.buildRecs++;
+		    joinStats.results++;
+		    outerRec_ = outerRec;
+		    return OK;
+		}
+		if (status != NOMORERECS) return status;
+		index->endScan();
+		scanning = false;
+	    }
+
+	    if ((status = outerScan->scanNext(rid)) != OK) return status;
+	    if ((status = outerScan->getRecord(outerRec)) != OK) return status;
+	    joinStats.probeRecs++;
+	    if (outerAttr.offset + outerAttr.length > outerRec.length) continue;
+	    status = index->startScan((char*) outerRec.data + outerAttr.offset, EQ);
+	    if (status != OK) return status;
+	    scanning = true;
+	}
+    }
+
+    const JoinStats & getJoinStats() const // get record counts
+    {
+	return joinStats;
+    }
+
+private:
+    AttrDesc	outerAttr;
+    HeapFileScan* outerScan;
+    Index*	index;
+    HeapFile*	inner;		// the indexed file
+    Record	outerRec;	// current outer record
+    bool	scanning;	// an index scan for outerRec is open
+    JoinStats	joinStats;
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <string>
+#include "page.h"
+#include "buf.h"
+
+// A LogMgr appends physiological records of heap file updates to a
+// write-ahead log, a unix file written directly.  A record names the
+// file and page it changes and describes the change within the page:
+// the record inserted into a slot, the slot deleted, or a new last page
+// linked after the old one.  Each also stands for the header update
+// that goes with it (recCnt, lastPage and pageCnt), so headers need no
+// records of their own.
+//
+// Records collect in memory and are written once LOGBUFSIZE bytes are
+// waiting, but only made durable (fsync) when flushed.  Commits are
+// grouped: commit() appends a commit record and syncs once groupSize
+// commits are waiting, so a group of transactions shares one fsync;
+// the caller learns its commit is durable when getFlushedLSN() reaches
+// the LSN it was given.  The BufMgr a LogMgr is attached to enforces
+// the write-ahead rule, flushing the log up to a dirty frame's LSN
+// before writing the frame.
+//
+// A fuzzy checkpoint of the BufMgr appends a LOG_CHECKPOINT record when
+// it begins, carrying the transaction open at the time and the dirty
+// page table, and a LOG_CHECKPOINT_END record once every page in the
+// table has been written, carrying the redo point: the earliest recLSN
+// of the table, before which every logged update is then on disk.
+//
+// Every data page carries the LSN of the last logged update it holds
+// (Page::getLSN), so a page on disk tells which records it already has.
+// At restart redoLog reads the log back with a LogScan and applies the
+// records a page is missing, starting from the redo point of the last
+// checkpoint that ended; repairHeapFiles then recounts the headers.
+// LSNs are offsets in the log file, so a log must be kept as long as
+// pages stamped from it remain: removing it, and starting LSNs over
+// from 0, would make every page look newer than the records of a new
+// log.
+
+const int LOGBUFSIZE = 64 * 1024;  // bytes of records written at once
+
+enum LogType { LOG_INSERT = 1, LOG_DELETE, LOG_NEWPAGE, LOG_COMMIT,
+               LOG_CHECKPOINT, LOG_CHECKPOINT_END };
+
+// every log record starts with this header, followed by nameLen bytes
+// of file name and then, for LOG_INSERT, the record inserted, for
+// LOG_CHECKPOINT, pageNo dirty page table entries (an LSN, a page
+// number, a short name length and the file name each), and for
+// LOG_CHECKPOINT_END, the LSN of the checkpoint's LOG_CHECKPOINT and
+// the redo point, the LSN redo starts from
+struct LogRecHdr
+{
+  int		length;		// bytes of the log record, header included
+  unsigned	checksum;	// of the bytes after this field
+  short		type;		// LogType
+  short		nameLen;	// bytes of the file name
+  int		txn;		// transaction, 0 outside of one
+  int		pageNo;		// page changed
+  int		slotNo;		// slot changed; LOG_NEWPAGE: the page linked from
+};
+
+struct LogStats
+{
+  int records;    // log records appended
+  long bytes;     // bytes appended
+  int commits;    // commit records
+  int syncs;      // fsyncs of the log
+  int walSyncs;   // of which forced by the write-ahead rule
+
+  void clear()
+    {
+      records = commits = syncs = walSyncs = 0;
+      bytes = 0;
+    }
+
+  LogStats()
+    {
+      clear();
+    }
+};
+
+class LogMgr {
+public:
+
+    // open log file name, creating it if needed, and append to it;
+    // UNIXERR if it cannot be opened, BADSCANPARM if groupSize is
+    // below 1
+    LogMgr(const string & name, const int groupSize, Status & status);
+
+    // flush the log and close it; detach it from the BufMgr first
+    ~LogMgr();
+
+    // start a transaction, ending any still open, and return its id
+    const int begin();
+
+    // append the commit record of the current transaction, setting lsn
+    // to the LSN that makes it durable; syncs if groupSize commits wait
+    const Status commit(LSN & lsn);
+
+    // make the log durable up to lsn; walRule counts a sync done for
+    // the write-ahead rule
+    const Status flush(const LSN lsn, const bool walRule = false);
+
+    // append the record of an update of heap file fileName and return
+    // its LSN
+    const LSN logInsert(const char* fileName, const RID & rid, const Record & rec);
+    const LSN logDelete(const char* fileName, const RID & rid);
+    const LSN logNewPage(const char* fileName, const int pageNo, const int prevPageNo);
+
+    // append the records that begin a checkpoint, with a dirty page table
+    // of cnt entries in length bytes, and end it, with the LSN redo is
+    // to start from
+    const LSN logCheckpoint(const char* table, const int length, const int cnt);
+    const LSN logCheckpointEnd(const LSN beginLSN, const LSN redoLSN);
+
+    const LSN getFlushedLSN() const // end of the durable part of the log
+    {
+	return flushedLSN;
+    }
+
+    const LSN getEndLSN() const // end of the log
+    {
+	return bufStart + buf.size();
+    }
+
+    const int getGroupSize() const { return groupSize; }
+    void setGroupSize(const int size) { if (size > 0) groupSize = size; }
+
+    const LogStats & getLogStats() const // get record and sync counts
+    {
+	return logStats;
+    }
+
+private:
+    string	name;
+    int		fd;		// unix file of the log
+    int		groupSize;	// commits that share a sync
+    vector<char> buf;		// records not yet written
+    LSN		bufStart;	// LSN of buf[0]
+    LSN		flushedLSN;	// end of the durable part of the log
+    Status	writeStatus;	// error of an earlier write, reported by flush
+    int		txn;		// current transaction, 0 if none
+    int		nextTxn;
+    int		waiting;	// commits appended since the last sync
+    LogStats	logStats;
+
+    const LSN append(const LogType type, const char* fileName, const int pageNo,
+                     const int slotNo, const char* data, const int length);
+    const Status write();
+};
+
+// A LogScan reads a log back from its start, one record at a time.  The
+// log ends at the first record that is cut short or fails its checksum,
+// the torn tail a crash can leave.
+
+class LogScan {
+public:
+
+    // open log file name for reading; UNIXERR if it cannot be opened
+    LogScan(const string & name, Status & status);
+    ~LogScan();
+
+    // read the next record: hdr gets its header, data points at what
+    // follows the header (the file name, then the record's data) until
+    // the next call, and lsn is set to the LSN past the record; FILEEOF
+    // at the end of the log, UNIXERR if reading fails
+    const Status next(LogRecHdr & hdr, const char* & data, LSN & lsn);
+
+    // go back to the first record
+    void rewind();
+
+    // cut the file after the last record read, dropping a torn tail
+    const Status truncate();
+
+    const LSN getEnd() const // LSN past the last record read
+    {
+	return bufStart + at;
+    }
+
+private:
+    int		fd;		// unix file of the log
+    vector<char> buf;		// bytes read ahead
+    LSN		bufStart;	// LSN of buf[0]
+    int		at;		// next record in buf
+
+    const Status fill(const int length);
+};
+
+#endif
@@ -11,6 +11,10 @@ struct RID{
 
 const RID NULLRID = {-1,-1};
 
+// log sequence number: the byte offset in the write-ahead log just past
+// a log record
+typedef long LSN;
+
 struct Record
 {
   void* data;
@@ -24,7 +28,7 @@ struct slot_t {
 };
 
 const unsigned PAGESIZE = 1024;
-const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
+const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+sizeof(LSN)+2*sizeof(int);
 const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
 // size of the data area of a page
 
@@ -42,7 +46,8 @@ private:
     short	slotCnt; // number of slots in use;
     short	freePtr; // offset of first free byte in data[]
     short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    unsigned short seq; // position in the file's page chain, from 1, mod 65536
+    LSN		lsn;      // LSN of the last logged update of the page, 0 if none
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
 
@@ -52,6 +57,11 @@ public:
 
     const Status getNextPage(int& pageNo) const; // returns value of nextPage
     const Status setNextPage(const int pageNo); // sets value of nextPage to pageNo
+    const int getPageNo() const; // returns value of curPage
+    const int getSeq() const;    // returns value of seq
+    void setSeq(const int seq);  // sets seq to seq modulo 65536
+    const LSN getLSN() const;    // returns value of lsn
+    void setLSN(const LSN lsn);  // sets lsn to lsn
     const short getFreeSpace() const; // returns amount of free space
 
     // inserts a new record (rec) into the page, returns RID of record 
@@ -72,4 +82,78 @@ public:
     const Status getRecord(const RID & rid, Record & rec);
 };
 
+// Record-level operations on a data page, independent of its layout.
+// A HeapFile picks one of these tables when it is opened and goes
+// through it for every page it touches.  Every layout keeps seq, lsn,
+// nextPage and curPage in the same place as Page, so the page chain
+// itself is always followed with Page::getNextPage()/setNextPage(),
+// and the LSN read and stamped with Page::getLSN()/setLSN().
+//
+// Layouts that do not store a record contiguously assemble it in the
+// caller's buf (PAGESIZE bytes) for getRecord and getAttr, so the
+// returned pointer is only good until the next call with that buf.
+
+struct PageOps
+{
+    // initialize a new page; like is an existing page of the same file,
+    // for layouts that keep their format on every page
+    void (*init)(Page* page, const int pageNo, const Page* like);
+    const Status (*insertRecord)(Page* page, const Record & rec, RID& rid);
+    const Status (*deleteRecord)(Page* page, const RID & rid);
+    const Status (*firstRecord)(const Page* page, RID& firstRid);
+    const Status (*nextRecord)(const Page* page, const RID & curRid,
+                               RID& nextRid);
+    const Status (*getRecord)(Page* page, const RID & rid, Record & rec,
+                              char* buf);
+    // returns pointer to length bytes at offset within the record,
+    // or NULL if the record is invalid or shorter than offset+length
+    const char* (*getAttr)(Page* page, const RID & rid, const int offset,
+                           const int length, char* buf);
+    const short (*getFreeSpace)(const Page* page);
+};
+
+// Builds a PageOps table for any class P with Page's record interface
+// that is overlaid on a buffer pool frame and stores records contiguously.
+
+template <class P>
+struct PageOpsFor
+{
+    static void init(Page* page, const int pageNo, const Page* like)
+    { ((P*)page)->init(pageNo); }
+    static const Status insertRecord(Page* page, const Record & rec, RID& rid)
+    { return ((P*)page)->insertRecord(rec, rid); }
+    static const Status deleteRecord(Page* page, const RID & rid)
+    { return ((P*)page)->deleteRecord(rid); }
+    static const Status firstRecord(const Page* page, RID& firstRid)
+    { return ((const P*)page)->firstRecord(firstRid); }
+    static const Status nextRecord(const Page* page, const RID & curRid,
+                                   RID& nextRid)
+    { return ((const P*)page)->nextRecord(curRid, nextRid); }
+    static const Status getRecord(Page* page, const RID & rid, Record & rec,
+                                  char* buf)
+    { return ((P*)page)->getRecord(rid, rec); }
+    static const char* getAttr(Page* page, const RID & rid, const int offset,
+                               const int length, char* buf)
+    {
+        Record rec;
+        if (((P*)page)->getRecord(rid, rec) != OK ||
+            offset + length > rec.length)
+            return NULL;
+        return (const char*)rec.data + offset;
+    }
+    static const short getFreeSpace(const Page* page)
+    { return ((const P*)page)->getFreeSpace(); }
+
+    static const PageOps ops;
+};
+
+template <class P>
+const PageOps PageOpsFor<P>::ops = {
+    init, insertRecord, deleteRecord, firstRecord,
+    nextRecord, getRecord, getAttr, getFreeSpace
+};
+
+// operations for the variable-length slotted layout implemented by Page
+const PageOps* const slottedPageOps = &PageOpsFor<Page>::ops;
+
 #endif
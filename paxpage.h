@@ -0,0 +1,73 @@
+#ifndef PAXPAGE_H
+#define PAXPAGE_H
+
+#include "page.h"
+
+// descriptor of one column (mini page) of a PAX page
+struct PaxCol {
+    short	recOffset;  // offset of the column's bytes within a record
+    short	length;     // number of bytes the column holds per record
+    short	pageOffset; // offset of the column's mini page in data[]
+};
+
+const int MAXPAXCOLS = 17;
+const unsigned PAXHDRSIZE = 7*sizeof(short) + sizeof(LSN) + 2*sizeof(int);
+
+// Class definition for a PAX (partition attributes across) data page.
+// The page holds fixed-length records, but instead of storing them
+// one after another it splits every record into columns and keeps
+// the values of each column contiguously in its own mini page.  A
+// scan that filters on one attribute then touches only that mini
+// page; full records are assembled only when they are asked for.
+//
+// data[] starts with the column descriptors, followed by the slot
+// validity bitmap and the mini pages, each aligned on a word boundary.
+// The last 18 bytes (seq, lsn, nextPage, curPage) are laid out as in Page.
+
+class PaxPage {
+private:
+    short	recLen;    // length of every record
+    short	colCnt;    // number of columns
+    short	slots;     // number of record slots on the page
+    short	recCnt;    // number of valid records on the page
+    short	slotHigh;  // one past the highest slot ever used
+    short	mapOffset; // offset of the validity bitmap in data[]
+    char	data[PAGESIZE - PAXHDRSIZE];
+    unsigned short seq;    // position in the file's page chain, as in Page
+    LSN		lsn;       // LSN of the last logged update, as in Page
+    int		nextPage;  // forwards pointer
+    int		curPage;   // page number of current pointer
+
+    PaxCol* cols() { return (PaxCol*)data; }
+    const PaxCol* cols() const { return (const PaxCol*)data; }
+    bool isValid(const int slotNo) const;
+
+public:
+    // lay out an empty page for records of length recLen split into
+    // colCnt columns that together cover the record exactly once
+    const Status format(const int pageNo, const int recLen,
+                        const int colCnt, const PaxCol* cols);
+
+    // initialize a new page with the same format as page like
+    void init(const int pageNo, const PaxPage* like);
+    void dumpPage() const;
+
+    const short getFreeSpace() const;
+    const short getSlots() const { return slots; }
+
+    const Status insertRecord(const Record & rec, RID& rid);
+    const Status deleteRecord(const RID & rid);
+    const Status firstRecord(RID& firstRid) const;
+    const Status nextRecord (const RID & curRid, RID& nextRid) const;
+
+    // assembles the record with RID rid in buf
+    const Status getRecord(const RID & rid, Record & rec, char* buf) const;
+
+    // returns pointer to an attribute, reading only the columns it spans
+    const char* getAttr(const RID & rid, const int offset,
+                        const int length, char* buf) const;
+};
+
+extern const PageOps paxPageOps;
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "heapfile.h"
+
+// An EntrySorter sorts fixed-length entries in bounded memory.  Entries
+// added with add() collect in a buffer of memPages pages; each time it
+// fills, the buffer is sorted and written out as a run.  next() then
+// merges the runs, first combining them memPages-1 at a time into
+// longer runs until one merge pass remains.  Runs are kept in a
+// temporary DB file whose pages are read and written through File
+// directly, sequentially and without the buffer pool; the file is
+// destroyed with the sorter.
+
+// negative, zero or positive as entry a sorts before, with or after b
+typedef const int (*EntryCompare)(const char* a, const char* b, const void* arg);
+
+// A tree of losers for merging k sorted sources.  Each internal node
+// holds the source that lost the match played there, tree[0] the
+// overall winner, so after the winner's source advances only the
+// log2(k) matches on its path are replayed.  Source provides
+// before(a, b), true if the current item of source a comes out before
+// that of source b; an exhausted source comes after every other.
+
+template <class Source>
+class LoserTree {
+public:
+    void init(const Source* src_, const int k_)
+    {
+	src = src_;
+	k = k_;
+	tree.assign(k, -1);  // -1 wins every match until all leaves played
+	for (int s = k - 1; s >= 0; s--) adjust(s);
+    }
+
+    const int winner() const { return tree[0]; }
+
+    // replay the matches of the winner after its source advanced
+    void replay() { adjust(tree[0]); }
+
+private:
+    const Source* src;
+    int k;
+    vector<int> tree;
+
+    void adjust(int s)
+    {
+	for (int t = (s + k) / 2; t > 0; t /= 2)
+	    if (tree[t] == -1 || (s != -1 && src->before(tree[t], s)))
+		swap(s, tree[t]);
+	tree[0] = s;
+    }
+};
+
+class EntrySorter {
+public:
+
+    // sort entries of entrySize bytes ordered by compare(a, b, arg);
+    // INSUFMEM if memPages is below 3, BADSORTPARM if an entry does not
+    // fit on a page
+    EntrySorter(const string & tmpName, const int entrySize,
+                EntryCompare compare, const void* arg,
+                const int memPages, Status & status);
+    ~EntrySorter();
+
+    // add an entry; BADSORTPARM once next() has been called
+    const Status add(const char* entry);
+
+    // return the next entry in sorted order, good until the next call;
+    // FILEEOF after the last one
+    const Status next(const char* & entry);
+
+    const int getRunCnt() const // runs written by run formation
+    {
+	return runCnt;
+    }
+
+private:
+    struct Run
+    {
+	int firstPage;	// runs are written to consecutive pages
+	int entryCnt;
+    };
+
+    string	tmpName;	// name of temporary run file
+    File*	file;		// run file, NULL until the first run is written
+    int		entrySize;
+    int		perPage;	// entries per run page
+    int		memPages;	// memory budget in pages
+    EntryCompare compare;
+    const void*	arg;
+
+    vector<char> buf;		// run formation buffer
+    int		bufCnt;		// entries in buf
+    vector<Run>	runs;		// runs still to be merged
+    int		runCnt;
+    bool	merging;	// next() has been called
+
+    // merge state: one page buffer and position per input run, and a
+    // tree of losers over the runs
+    vector<Run>	inRuns;
+    vector<int>	inPos;
+    vector<char> inPages;
+    LoserTree<EntrySorter> tree;
+    int		lastRun;	// run whose entry next() returned, -1 if none
+
+    friend class LoserTree<EntrySorter>;
+    const char* current(const int r) const
+    { return &inPages[r * PAGESIZE + (inPos[r] % perPage) * entrySize]; }
+    const bool before(const int r, const int s) const
+    {
+	if (inPos[r] == inRuns[r].entryCnt) return false;
+	if (inPos[s] == inRuns[s].entryCnt) return true;
+	int c = compare(current(r), current(s), arg);
+	return c < 0 || (c == 0 && r < s);
+    }
+
+    const Status writeRun();
+    const Status writePage(const char* page, int & pageNo);
+    const Status loadPage(const int r);
+    const Status startMerge(const int first, const int cnt);
+    const Status mergeNext(const char* & entry);
+};
+
+// A SortedFile returns the records of a heap file in the order of one
+// attribute, sorted in a budget of maxFrames buffer pool frames.  Run
+// generation copies records from a HeapFileScan into a workspace of
+// maxFrames pages, sorts it when full and writes it out as a run, a
+// temporary heap file.  Runs are merged through a tree of losers; each
+// open run holds two frames (its header and current page), so at most
+// (maxFrames-2)/2 runs are merged at once, and runs are combined into
+// longer ones until the rest can be merged in one pass, which next()
+// streams.  Records too short to hold the attribute sort first.  A file
+// found already in order is streamed straight from a scan of it; the
+// check stops at the first record out of order.
+
+struct SortStats
+{
+  int records;    // records sorted
+  int runs;       // runs written by run generation
+  int merges;     // intermediate merges before the final one
+  int inOrder;    // 1 if the file was already in order
+
+  void clear()
+    {
+      records = runs = merges = inOrder = 0;
+    }
+
+  SortStats()
+    {
+      clear();
+    }
+};
+
+class SortedFile {
+public:
+
+    // sort heap file fileName on attribute (offset, length, type);
+    // BADSORTPARM if the attribute is malformed, INSUFMEM if maxFrames
+    // is below 6
+    SortedFile(const string & fileName, const int offset, const int length,
+               const Datatype type, const int maxFrames, Status & status);
+    ~SortedFile();
+
+    // return the next record in sorted order, good until the next call;
+    // FILEEOF after the last one
+    const Status next(Record & rec);
+
+    // write the records next() has not yet returned to new heap file outName
+    const Status writeFile(const string & outName);
+
+    const SortStats & getSortStats() const // get run and merge counts
+    {
+	return sortStats;
+    }
+
+private:
+    string	fileName;
+    int		offset;
+    int		length;
+    Datatype	type;
+    int		maxFrames;
+    SortStats	sortStats;
+
+    vector<char> work;		// run generation workspace
+    vector<int>	recs;		// offsets of the records in work
+    int		workUsed;	// bytes of work in use
+    int		nextRec;	// next record of work for next(), -1 if merging
+
+    vector<string> runs;	// run files still to be merged
+    bool	merging;	// next() has been called
+
+    // merge state: a scan and current record per input run
+    vector<HeapFileScan*> inScans;
+    vector<Record> inRecs;
+    vector<bool> inDone;
+    LoserTree<SortedFile> tree;
+    int		lastRun;	// run whose record next() returned, -1 if none
+
+    friend class LoserTree<SortedFile>;
+    struct RecLess;
+    const int recCompare(const char* a, const int alen,
+                         const char* b, const int blen) const;
+    const bool before(const int r, const int s) const
+    {
+	if (inDone[r]) return false;
+	if (inDone[s]) return true;
+	int c = recCompare((char*)inRecs[r].data, inRecs[r].length,
+	                   (char*)inRecs[s].data, inRecs[s].length);
+	return c < 0 || (c == 0 && r < s);
+    }
+
+    const Status checkOrder();
+    const Status generateRuns();
+    const Status writeRun();
+    const Status advance(const int r);
+    const Status startMerge(const int cnt);
+    const Status mergeNext(Record & rec);
+    void endMerge();
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef TOPN_H
+#define TOPN_H
+
+#include "heapfile.h"
+
+// A TopN keeps the n records with the smallest (or largest) values of
+// an attribute among those offered to it, in a heap of n record copies
+// whose root is the worst record kept, so memory stays O(n) however
+// many records are offered.  Once n are kept, a record is only copied
+// if it beats the root.
+//
+// scanFile() offers the records of a heap file.  On a numeric attribute
+// it filters the scan on the root's value, tightening the filter as the
+// root improves; if the file keeps zone maps of the attribute, pages are
+// read best first and the scan ends at the first page whose zone cannot
+// beat the root.  Records too short to hold the attribute are ignored.
+
+struct TopNStats
+{
+  int records;      // records offered
+  int kept;         // records copied into the heap
+  int pagesRead;    // data pages read by scanFile
+  int pagesSkipped; // data pages scanFile ruled out unread
+
+  void clear()
+    {
+      records = kept = pagesRead = pagesSkipped = 0;
+    }
+
+  TopNStats()
+    {
+      clear();
+    }
+};
+
+class TopN {
+public:
+
+    // keep the n records with the smallest values of attr, or the
+    // largest if largest is set; BADSCANPARM if attr is malformed or n
+    // is below 1
+    TopN(const AttrDesc & attr, const int n, const bool largest,
+         Status & status);
+
+    // offer a record; BADSCANPARM once next() has been called
+    const Status add(const Record & rec);
+
+    // offer the records of heap file fileName
+    const Status scanFile(const string & fileName);
+
+    // return the records kept, best first, good until the TopN is
+    // destroyed; FILEEOF after the last one
+    const Status next(Record & rec);
+
+    const TopNStats & getTopNStats() const // get record and page counts
+    {
+	return topNStats;
+    }
+
+private:
+    AttrDesc	attr;
+    int		n;
+    bool	largest;
+    TopNStats	topNStats;
+
+    vector<vector<char> > recs;	// the records kept
+    vector<int>	heap;		// indexes into recs, worst at the root
+    vector<char> bound;		// attribute of the root once n are kept
+    bool	returning;	// next() has been called
+    int		nextRec;	// position in heap next() returns next
+
+    struct Worse;
+    const int compare(const char* a, const char* b) const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef ZONEMAP_H
+#define ZONEMAP_H
+
+#include "heapfile.h"
+
+// A heap file whose schema declares INTEGER or FLOAT attributes keeps
+// a zone map directory: a chain of ZoneDirPages with one entry per data
+// page, in the same order as the data page chain.  An entry holds the
+// page number and a Zone for every numeric attribute ("zone number" is
+// the position of the attribute among the numeric ones).  Zones are
+// widened on insert and never narrowed, so after deletions they may
+// cover values no longer present on the page.  A record changed in
+// place, after HeapFileScan::markDirty, may take any value, so the
+// zones of its page are opened up to cover every value.
+//
+// If the file declares a Bloom filter attribute, each entry also ends
+// with a Bloom filter of the values that attribute takes on the page.
+// Deleting a record does not clear its bits either; opening up a page
+// sets all of them.
+
+// number of zones (numeric attributes) kept for a file
+const int zoneCount(const FileHdrPage* hdr);
+
+class ZoneDirPage {
+private:
+    int		nextDir;    // next directory page, -1 if last
+    short	zoneCnt;    // zones per entry
+    short	entryCnt;   // entries in use
+    short	bloomBytes; // Bloom filter bytes per entry
+    short	dummy;      // for alignment purposes
+    char	data[PAGESIZE - sizeof(int) - 4*sizeof(short)];
+
+    const int entrySize() const
+    { return sizeof(int) + zoneCnt * sizeof(Zone) + bloomBytes; }
+
+public:
+    void init(const int zoneCnt, const int bloomBytes);
+
+    const int getNextDir() const { return nextDir; }
+    void setNextDir(const int pageNo) { nextDir = pageNo; }
+    const int getEntryCnt() const { return entryCnt; }
+    const bool isFull() const
+    { return (entryCnt + 1) * entrySize() > (int) sizeof(data); }
+
+    // add an entry with empty zones for data page pageNo
+    void append(const int pageNo, const FileHdrPage* hdr);
+
+    // widen the zones of entry to cover record rec and add it to the
+    // entry's Bloom filter
+    void widen(const int entry, const FileHdrPage* hdr, const Record & rec);
+
+    // make the zones of entry cover every value and its Bloom filter
+    // hold every key
+    void cover(const int entry, const FileHdrPage* hdr);
+
+    // true if the page is laid out as a directory page of hdr's file
+    const bool isValid(const FileHdrPage* hdr) const
+    {
+	return zoneCnt == zoneCount(hdr) && bloomBytes == hdr->bloomBytes &&
+	    entrySize() > (int) sizeof(int) && entryCnt >= 0 &&
+	    entryCnt * entrySize() <= (int) sizeof(data);
+    }
+
+    const int pageNo(const int entry) const
+    { return *(const int*)&data[entry * entrySize()]; }
+    Zone* zonesOf(const int entry)
+    { return (Zone*)&data[entry * entrySize() + sizeof(int)]; }
+    unsigned char* bloomOf(const int entry)
+    { return (unsigned char*)&data[(entry + 1) * entrySize() - bloomBytes]; }
+};
+
+// bit numbers of key in a Bloom filter of bits bits; STRING keys end at
+// their first null byte, like the strncmp in HeapFileScan::matchRec
+void bloomProbes(const char* key, const int length, const Datatype type,
+                 const int bits, int probes[BLOOMHASHES]);
+
+// zone number of the declared attribute (offset, length, type),
+// or -1 if it is not a numeric attribute of the schema
+const int zoneNoOf(const FileHdrPage* hdr, const int offset,
+                   const int length, const Datatype type);
+
+// true if some value in zone could satisfy "value op filter"
+const bool zoneMayMatch(const Zone & zone, const Datatype type,
+                        const char* filter, const Operator op);
+
+// append an empty entry for a new last data page, extending the
+// directory with a new page if needed
+const Status zoneDirAppend(File* file, FileHdrPage* hdr, const int pageNo);
+
+// widen the zones of the last data page to cover record rec and add
+// it to the page's Bloom filter
+const Status zoneDirWiden(File* file, FileHdrPage* hdr, const Record & rec);
+
+// cover every value with the zones and Bloom filter of data page
+// pageNo, whose records may have changed in place
+const Status zoneDirCover(File* file, const FileHdrPage* hdr, const int pageNo);
+
+// read zone zoneNo of every data page, in chain order
+const Status zoneDirLoad(File* file, const FileHdrPage* hdr, const int zoneNo,
+                         vector<int> & pages, vector<Zone> & zones);
+
+// read the Bloom filter of every data page, in chain order
+const Status bloomDirLoad(File* file, const FileHdrPage* hdr,
+                          vector<int> & pages, vector<unsigned char> & blooms);
+
+#endif